@@ -0,0 +1,70 @@
+//
+//  AudioLevelMeter.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+import BambuserBroadcaster
+
+/// Samples the BambuserView audio levels at a fixed, low rate and keeps the
+/// latest values with falloff applied, so UI can read `levels` every frame
+/// without querying the library each time.
+class AudioLevelMeter {
+    struct Levels {
+        var average: Float
+        var peak: Float
+    }
+
+    static let silence: Float = -160
+    /// Falloff applied to the displayed average, in dB per second.
+    static let decayRate: Float = 20
+
+    var onLevels: ((Levels) -> Void)?
+
+    private(set) var levels = Levels(average: AudioLevelMeter.silence, peak: AudioLevelMeter.silence)
+
+    private weak var bambuserView: BambuserView?
+    private let rate: Double
+    private var timer: Timer?
+
+    init(bambuserView: BambuserView, rate: Double = 15) {
+        self.bambuserView = bambuserView
+        self.rate = rate
+    }
+
+    deinit {
+        timer?.invalidate()
+    }
+
+    func start() {
+        if timer != nil {
+            return
+        }
+        timer = Timer.scheduledTimer(withTimeInterval: 1 / rate, repeats: true) { [weak self] _ in
+            self?.sample()
+        }
+    }
+
+    func stop() {
+        timer?.invalidate()
+        timer = nil
+        levels = Levels(average: AudioLevelMeter.silence, peak: AudioLevelMeter.silence)
+    }
+
+    /// Maps a level in dB to 0...1 over a 60 dB display range.
+    static func normalized(_ level: Float) -> Float {
+        return min(max((level + 60) / 60, 0), 1)
+    }
+
+    private func sample() {
+        guard let bambuserView = bambuserView else {
+            return
+        }
+        let decayed = levels.average - AudioLevelMeter.decayRate / Float(rate)
+        levels.average = max(bambuserView.audioAveragePowerLevel, decayed)
+        levels.peak = bambuserView.audioPeakHoldLevel
+        onLevels?(levels)
+    }
+}
@@ -0,0 +1,97 @@
+//
+//  BroadcastEventBus.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+
+/// Gathers BambuserViewDelegate callbacks and delivers them as one batch per tick on
+/// a caller-chosen queue. Health and viewer counts are coalesced to their latest value;
+/// state changes are kept in the order they arrived.
+class BroadcastEventBus {
+    enum StateEvent {
+        case started
+        case stopped
+        case disconnected
+        case resumed
+    }
+
+    struct Batch {
+        var states: [StateEvent] = []
+        var health: Int?
+        var currentViewers: Int?
+        var totalViewers: Int?
+    }
+
+    var onBatch: ((Batch) -> Void)?
+
+    /// Callbacks received and batches delivered, to compare dispatch counts.
+    var postedCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return posted
+    }
+
+    var deliveredCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return delivered
+    }
+
+    private let queue: DispatchQueue
+    private let interval: TimeInterval
+    private let lock = NSLock()
+    private var batch = Batch()
+    private var scheduled = false
+    private var posted = 0
+    private var delivered = 0
+
+    init(queue: DispatchQueue = DispatchQueue.main, interval: TimeInterval = 1.0 / 30.0) {
+        self.queue = queue
+        self.interval = interval
+    }
+
+    func post(_ state: StateEvent) {
+        update { $0.states.append(state) }
+    }
+
+    func postHealth(_ health: Int) {
+        update { $0.health = health }
+    }
+
+    func postCurrentViewers(_ viewers: Int) {
+        update { $0.currentViewers = viewers }
+    }
+
+    func postTotalViewers(_ viewers: Int) {
+        update { $0.totalViewers = viewers }
+    }
+
+    private func update(_ change: (inout Batch) -> Void) {
+        lock.lock()
+        change(&batch)
+        posted += 1
+        let schedule = !scheduled
+        scheduled = true
+        lock.unlock()
+
+        if schedule {
+            queue.asyncAfter(deadline: .now() + interval) { [weak self] in
+                self?.flush()
+            }
+        }
+    }
+
+    private func flush() {
+        lock.lock()
+        let pending = batch
+        batch = Batch()
+        scheduled = false
+        delivered += 1
+        lock.unlock()
+
+        onBatch?(pending)
+    }
+}
@@ -0,0 +1,178 @@
+//
+//  BroadcastQualityController.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+
+/// Picks the capture framerate and broadcast size from the health values reported
+/// by BambuserView. While live, only the framerate follows health, since it applies
+/// immediately. maxBroadcastDimension can not be altered during a broadcast, so the
+/// size moves at most one step per broadcast, decided when it stops from its average
+/// health, and takes effect on the next startBroadcasting. The size used is the lower
+/// of what health and the last linktest allow.
+class BroadcastQualityController {
+    struct Decision {
+        let maxBroadcastDimension: Int
+        let framerate: Float
+        let smoothedHealth: Double
+    }
+
+    /// Steps within the 200-1280 range accepted by maxBroadcastDimension.
+    static let dimensionSteps = [1280, 960, 720, 640, 480, 360, 200]
+    /// Approximate uplink, in bytes per second, each step needs to stream smoothly.
+    static let requiredUplink: [Float] = [320_000, 190_000, 140_000, 100_000, 64_000, 40_000, 20_000]
+    /// Steps within the 24-30 fps range accepted by setFramerate:minFramerate:.
+    static let framerateSteps: [Float] = [30, 28, 26, 24]
+    static let minFramerate: Float = 24
+
+    static let downgradeHealth = 60.0
+    static let upgradeHealth = 90.0
+    static let recoveredHealth = 80
+    static let downgradeHold: TimeInterval = 3
+    static let upgradeHold: TimeInterval = 15
+
+    var onDecision: ((Decision) -> Void)?
+
+    private(set) var healthStepIndex = 0
+    private(set) var uplinkStepIndex = 0
+    private(set) var framerateIndex = 0
+    private(set) var smoothedHealth = 100.0
+    private(set) var stallCount = 0
+    private(set) var recoveryTimes: [TimeInterval] = []
+
+    private var healthSum = 0.0
+    private var healthSamples = 0
+    private var stallStart: Date?
+    private var lowSince: Date?
+    private var highSince: Date?
+
+    var stepIndex: Int {
+        return max(healthStepIndex, uplinkStepIndex)
+    }
+
+    var maxBroadcastDimension: Int {
+        return BroadcastQualityController.dimensionSteps[stepIndex]
+    }
+
+    var framerate: Float {
+        return BroadcastQualityController.framerateSteps[framerateIndex]
+    }
+
+    var averageRecoveryTime: TimeInterval? {
+        if recoveryTimes.isEmpty {
+            return nil
+        }
+        return recoveryTimes.reduce(0, +) / Double(recoveryTimes.count)
+    }
+
+    /// Mean of the health values reported during the current broadcast.
+    var averageHealth: Double? {
+        if healthSamples == 0 {
+            return nil
+        }
+        return healthSum / Double(healthSamples)
+    }
+
+    func broadcastStarted() {
+        smoothedHealth = 100.0
+        healthSum = 0
+        healthSamples = 0
+        stallCount = 0
+        recoveryTimes.removeAll()
+        stallStart = nil
+        lowSince = nil
+        highSince = nil
+        stepFramerate(by: -framerateIndex)
+    }
+
+    /// Makes the one size decision for the broadcast that just ended.
+    func broadcastStopped() {
+        guard let average = averageHealth else {
+            return
+        }
+        if average < BroadcastQualityController.downgradeHealth {
+            step(by: 1)
+        } else if average > BroadcastQualityController.upgradeHealth {
+            step(by: -1)
+        }
+    }
+
+    /// Caps the size by a linktest result taken before the broadcast.
+    func uplinkMeasured(bytesPerSecond speed: Float) {
+        let supported = BroadcastQualityController.requiredUplink.firstIndex { speed >= $0 * 1.25 }
+        let previous = stepIndex
+        uplinkStepIndex = supported ?? BroadcastQualityController.dimensionSteps.count - 1
+        if stepIndex != previous {
+            notify()
+        }
+    }
+
+    func healthUpdated(_ health: Int, at time: Date = Date()) {
+        smoothedHealth = smoothedHealth * 0.7 + Double(health) * 0.3
+        healthSum += Double(health)
+        healthSamples += 1
+
+        if health == 0 {
+            if stallStart == nil {
+                stallStart = time
+                stallCount += 1
+            }
+        } else if let start = stallStart, health >= BroadcastQualityController.recoveredHealth {
+            recoveryTimes.append(time.timeIntervalSince(start))
+            stallStart = nil
+        }
+
+        if smoothedHealth < BroadcastQualityController.downgradeHealth {
+            highSince = nil
+            let since = lowSince ?? time
+            lowSince = since
+            if time.timeIntervalSince(since) >= BroadcastQualityController.downgradeHold {
+                stepFramerate(by: 1)
+                lowSince = nil
+            }
+        } else if smoothedHealth > BroadcastQualityController.upgradeHealth {
+            lowSince = nil
+            let since = highSince ?? time
+            highSince = since
+            if time.timeIntervalSince(since) >= BroadcastQualityController.upgradeHold {
+                stepFramerate(by: -1)
+                highSince = nil
+            }
+        } else {
+            lowSince = nil
+            highSince = nil
+        }
+    }
+
+    @discardableResult
+    private func step(by delta: Int) -> Bool {
+        let next = min(max(healthStepIndex + delta, 0), BroadcastQualityController.dimensionSteps.count - 1)
+        if next == healthStepIndex {
+            return false
+        }
+        let previous = stepIndex
+        healthStepIndex = next
+        if stepIndex != previous {
+            notify()
+        }
+        return true
+    }
+
+    @discardableResult
+    private func stepFramerate(by delta: Int) -> Bool {
+        let next = min(max(framerateIndex + delta, 0), BroadcastQualityController.framerateSteps.count - 1)
+        if next == framerateIndex {
+            return false
+        }
+        framerateIndex = next
+        notify()
+        return true
+    }
+
+    private func notify() {
+        onDecision?(Decision(maxBroadcastDimension: maxBroadcastDimension, framerate: framerate, smoothedHealth: smoothedHealth))
+    }
+}
@@ -0,0 +1,85 @@
+//
+//  ChatFeed.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import UIKit
+import BambuserBroadcaster
+
+/// Collects incoming chat messages into a fixed-size ring and hands them to the
+/// BambuserView chatView in one batch per display frame, instead of touching UI for
+/// every message. At most displayRate messages a second are shown, the newest ones;
+/// the rest are counted as dropped. chatView itself keeps every message shown, and
+/// the library offers no way to trim it.
+class ChatFeed: NSObject {
+    static let capacity = 500
+    static let displayRate = 5.0
+
+    /// Messages never shown: overwritten in the ring, or over the rate limit.
+    private(set) var droppedCount = 0
+
+    private weak var bambuserView: BambuserView?
+    private var ring: [String]
+    private var head = 0
+    private var count = 0
+    private var pendingCount = 0
+    private var displayLink: CADisplayLink?
+    private var tokens = ChatFeed.displayRate
+    private var lastRefill = CACurrentMediaTime()
+
+    init(bambuserView: BambuserView) {
+        self.bambuserView = bambuserView
+        ring = [String](repeating: "", count: ChatFeed.capacity)
+        super.init()
+    }
+
+    /// The newest `n` retained messages, oldest first.
+    func newest(_ n: Int) -> [String] {
+        let n = min(n, count)
+        return (0..<n).map { ring[(head + ChatFeed.capacity - n + $0) % ChatFeed.capacity] }
+    }
+
+    func receive(_ message: String) {
+        ring[head] = message
+        head = (head + 1) % ChatFeed.capacity
+        count = min(count + 1, ChatFeed.capacity)
+        if pendingCount == ChatFeed.capacity {
+            droppedCount += 1
+        } else {
+            pendingCount += 1
+        }
+        if let displayLink = displayLink {
+            displayLink.isPaused = false
+        } else {
+            let link = CADisplayLink(target: self, selector: #selector(ChatFeed.flush))
+            link.add(to: RunLoop.main, forMode: RunLoop.Mode.common)
+            displayLink = link
+        }
+    }
+
+    func stop() {
+        displayLink?.invalidate()
+        displayLink = nil
+        pendingCount = 0
+    }
+
+    @objc private func flush() {
+        displayLink?.isPaused = true
+        if pendingCount == 0 {
+            return
+        }
+
+        let now = CACurrentMediaTime()
+        tokens = min(tokens + (now - lastRefill) * ChatFeed.displayRate, ChatFeed.displayRate)
+        lastRefill = now
+        let shown = min(pendingCount, Int(tokens))
+        for message in newest(shown) {
+            bambuserView?.displayMessage(message)
+        }
+        tokens -= Double(shown)
+        droppedCount += pendingCount - shown
+        pendingCount = 0
+    }
+}
@@ -0,0 +1,77 @@
+//
+//  LatencyEstimator.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+import BambuserPlayer
+
+/// Polls BambuserPlayer.endToEndLatency and keeps a stable estimate from it.
+/// Samples without clock sync (negative uncertainty) are ignored. The latency
+/// itself moves with the player's buffer, so the estimate is the newest sample in
+/// a sliding window whose uncertainty is within uncertaintySlack of the window's
+/// lowest. onEstimate only fires when the estimate moves by more than
+/// reportThreshold.
+class LatencyEstimator {
+    static let window = 30
+    static let interval: TimeInterval = 1
+    /// Change in latency or uncertainty, in seconds, that is reported again.
+    static let reportThreshold: Float = 0.05
+    /// How much worse than the window's best uncertainty, in seconds, a newer sample may be.
+    static let uncertaintySlack: Float = 0.1
+
+    var onEstimate: ((LatencyMeasurement) -> Void)?
+
+    private(set) var estimate: LatencyMeasurement?
+
+    private weak var player: BambuserPlayer?
+    private var samples: [LatencyMeasurement] = []
+    private var timer: Timer?
+
+    init(player: BambuserPlayer) {
+        self.player = player
+    }
+
+    deinit {
+        timer?.invalidate()
+    }
+
+    func start() {
+        if timer != nil {
+            return
+        }
+        timer = Timer.scheduledTimer(withTimeInterval: LatencyEstimator.interval, repeats: true) { [weak self] _ in
+            self?.sample()
+        }
+    }
+
+    func stop() {
+        timer?.invalidate()
+        timer = nil
+        samples.removeAll()
+        estimate = nil
+    }
+
+    private func sample() {
+        guard let measurement = player?.endToEndLatency, measurement.uncertainty >= 0 else {
+            return
+        }
+        samples.append(measurement)
+        if samples.count > LatencyEstimator.window {
+            samples.removeFirst()
+        }
+        guard let lowest = samples.map({ $0.uncertainty }).min(),
+              let best = samples.last(where: { $0.uncertainty <= lowest + LatencyEstimator.uncertaintySlack }) else {
+            return
+        }
+        if let previous = estimate,
+           abs(best.latency - previous.latency) < LatencyEstimator.reportThreshold,
+           abs(best.uncertainty - previous.uncertainty) < LatencyEstimator.reportThreshold {
+            return
+        }
+        estimate = best
+        onEstimate?(best)
+    }
+}
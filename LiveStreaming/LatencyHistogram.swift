@@ -0,0 +1,104 @@
+//
+//  LatencyHistogram.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+
+/// Log-linear latency histogram: eight sub-buckets per power of two of microseconds,
+/// so every recorded value is kept to within 12.5% using a fixed 256 counters.
+struct LatencyHistogram {
+    static let subBuckets = 8
+    static let bucketCount = 256
+
+    private(set) var counts = [UInt32](repeating: 0, count: LatencyHistogram.bucketCount)
+    private(set) var total: UInt64 = 0
+
+    mutating func record(_ interval: TimeInterval) {
+        counts[LatencyHistogram.index(for: interval)] &+= 1
+        total += 1
+    }
+
+    /// Lower bound of the bucket holding the given fraction (0...1) of samples.
+    func percentile(_ fraction: Double) -> TimeInterval {
+        if total == 0 {
+            return 0
+        }
+        let target = UInt64((Double(total) * fraction).rounded(.up))
+        var seen: UInt64 = 0
+        for (index, count) in counts.enumerated() {
+            seen += UInt64(count)
+            if seen >= max(target, 1) {
+                return LatencyHistogram.lowerBound(of: index)
+            }
+        }
+        return LatencyHistogram.lowerBound(of: LatencyHistogram.bucketCount - 1)
+    }
+
+    static func index(for interval: TimeInterval) -> Int {
+        let micros = UInt64(min(max(interval * 1_000_000, 0), 1e18))
+        if micros < UInt64(subBuckets) {
+            return Int(micros)
+        }
+        let exponent = 63 - micros.leadingZeroBitCount
+        let sub = Int((micros >> (exponent - 3)) & 7)
+        return min((exponent - 2) * subBuckets + sub, bucketCount - 1)
+    }
+
+    static func lowerBound(of index: Int) -> TimeInterval {
+        if index < subBuckets {
+            return Double(index) / 1_000_000
+        }
+        let exponent = index / subBuckets + 2
+        let micros = UInt64(subBuckets + index % subBuckets) << (exponent - 3)
+        return Double(micros) / 1_000_000
+    }
+}
+
+/// Histograms for the broadcast stages the app can observe from BambuserViewDelegate.
+class BroadcastTimings {
+    enum Stage: UInt8, CaseIterable {
+        case connect = 0
+        case reconnect = 1
+        case snapshot = 2
+    }
+
+    private(set) var histograms = [Stage: LatencyHistogram]()
+
+    func record(_ stage: Stage, _ interval: TimeInterval) {
+        histograms[stage, default: LatencyHistogram()].record(interval)
+    }
+
+    /// Logs p50/p95 per stage and the base64 dump, so a session's timings can be
+    /// pulled from the device log.
+    func log() {
+        for stage in Stage.allCases {
+            guard let histogram = histograms[stage] else {
+                continue
+            }
+            NSLog("%@ latency p50 %.3f s, p95 %.3f s (%llu samples)", String(describing: stage), histogram.percentile(0.5), histogram.percentile(0.95), histogram.total)
+        }
+        NSLog("Broadcast timings dump: %@", dump().base64EncodedString())
+    }
+
+    /// Compact little-endian dump: per stage its id, the number of non-empty
+    /// buckets, then (bucket index, count) pairs.
+    func dump() -> Data {
+        var data = Data()
+        for stage in Stage.allCases {
+            guard let histogram = histograms[stage] else {
+                continue
+            }
+            let buckets = histogram.counts.enumerated().filter { $0.element > 0 }
+            data.append(stage.rawValue)
+            withUnsafeBytes(of: UInt16(buckets.count).littleEndian) { data.append(contentsOf: $0) }
+            for (index, count) in buckets {
+                data.append(UInt8(index))
+                withUnsafeBytes(of: count.littleEndian) { data.append(contentsOf: $0) }
+            }
+        }
+        return data
+    }
+}
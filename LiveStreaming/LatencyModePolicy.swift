@@ -0,0 +1,74 @@
+//
+//  LatencyModePolicy.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+import BambuserPlayer
+
+/// Chooses the BambuserPlayer latencyMode from how often recent live sessions
+/// rebuffered. latencyMode can only be set before playVideo:, so the rebuffer rate
+/// of past sessions decides the buffer size of the next one.
+class LatencyModePolicy {
+    static let sessionsKey = "LatencyModePolicy.sessions"
+    static let historyLength = 5
+    /// Rebuffers per minute of playback above which the larger buffer is used.
+    static let highLatencyRebufferRate = 0.5
+
+    private let defaults: UserDefaults
+    private var playingSince: Date?
+    private var playedTime: TimeInterval = 0
+    private var rebufferCount = 0
+    private var live = false
+
+    init(defaults: UserDefaults = UserDefaults.standard) {
+        self.defaults = defaults
+    }
+
+    /// Rebuffers per minute over the stored sessions, each stored as [rebuffers, seconds played].
+    var rebufferRate: Double {
+        let sessions = defaults.array(forKey: LatencyModePolicy.sessionsKey) as? [[Double]] ?? []
+        let rebuffers = sessions.reduce(0) { $0 + $1[0] }
+        let minutes = sessions.reduce(0) { $0 + $1[1] } / 60
+        return minutes > 0 ? rebuffers / minutes : 0
+    }
+
+    func recommendedMode() -> BambuserLatencyMode {
+        return rebufferRate > LatencyModePolicy.highLatencyRebufferRate ? BambuserPlayerLatencyModeHigh : BambuserPlayerLatencyModeLow
+    }
+
+    func playing(live: Bool) {
+        self.live = live
+        if playingSince == nil {
+            playingSince = Date()
+        }
+    }
+
+    func buffering() {
+        if playingSince == nil {
+            return
+        }
+        paused()
+        rebufferCount += 1
+    }
+
+    func paused() {
+        if let since = playingSince {
+            playedTime += Date().timeIntervalSince(since)
+        }
+        playingSince = nil
+    }
+
+    func ended() {
+        paused()
+        if live && playedTime > 0 {
+            var sessions = defaults.array(forKey: LatencyModePolicy.sessionsKey) as? [[Double]] ?? []
+            sessions.append([Double(rebufferCount), playedTime])
+            defaults.set(Array(sessions.suffix(LatencyModePolicy.historyLength)), forKey: LatencyModePolicy.sessionsKey)
+        }
+        playedTime = 0
+        rebufferCount = 0
+    }
+}
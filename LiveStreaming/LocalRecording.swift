@@ -0,0 +1,76 @@
+//
+//  LocalRecording.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+
+/// Disk handling for the local copy written by BambuserView when saveLocally is set.
+enum LocalRecording {
+    /// Roughly the 4 Mbit/s a 720p local copy is written at.
+    static let bytesPerSecond: Int64 = 500_000
+    /// Free space required up front: five minutes of recording, about 150 MB.
+    static let minimumDuration: TimeInterval = 5 * 60
+    /// Archived recordings kept; older ones are deleted.
+    static let maxKept = 5
+
+    private static let queue = DispatchQueue(label: "LocalRecording", qos: .utility)
+
+    /// Checks free space before the broadcast starts, so a full disk is caught up front
+    /// instead of surfacing as kBambuserErrorNoFreeSpace halfway through. If the
+    /// capacity can not be read, recording is allowed and the library reports errors.
+    static func hasRoom(for duration: TimeInterval = minimumDuration) -> Bool {
+        let directory = URL(fileURLWithPath: NSTemporaryDirectory())
+        guard let values = try? directory.resourceValues(forKeys: [.volumeAvailableCapacityForImportantUsageKey]),
+              let available = values.volumeAvailableCapacityForImportantUsage else {
+            return true
+        }
+        return available >= Int64(duration) * bytesPerSecond
+    }
+
+    /// Moves a finished recording out of the temporary directory on a background
+    /// queue, keeping the file copy off the main thread. Archived files are excluded
+    /// from backup and only the newest maxKept are kept.
+    static func archive(_ filename: String, completion: @escaping (URL?) -> Void) {
+        queue.async {
+            let source = URL(fileURLWithPath: filename)
+            var destination: URL?
+            do {
+                let directory = try recordingsDirectory()
+                var target = directory.appendingPathComponent(source.lastPathComponent)
+                try FileManager.default.moveItem(at: source, to: target)
+                var values = URLResourceValues()
+                values.isExcludedFromBackup = true
+                try target.setResourceValues(values)
+                destination = target
+                prune(directory)
+            } catch {
+                NSLog("Failed to archive recording %@: %@", filename, error.localizedDescription)
+            }
+            DispatchQueue.main.async {
+                completion(destination)
+            }
+        }
+    }
+
+    private static func recordingsDirectory() throws -> URL {
+        let documents = try FileManager.default.url(for: .documentDirectory, in: .userDomainMask, appropriateFor: nil, create: true)
+        let directory = documents.appendingPathComponent("Recordings", isDirectory: true)
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+        return directory
+    }
+
+    private static func prune(_ directory: URL) {
+        let files = (try? FileManager.default.contentsOfDirectory(at: directory, includingPropertiesForKeys: [.creationDateKey])) ?? []
+        let newestFirst = files.sorted {
+            let first = (try? $0.resourceValues(forKeys: [.creationDateKey]).creationDate) ?? Date.distantPast
+            let second = (try? $1.resourceValues(forKeys: [.creationDateKey]).creationDate) ?? Date.distantPast
+            return first > second
+        }
+        for file in newestFirst.dropFirst(maxKept) {
+            try? FileManager.default.removeItem(at: file)
+        }
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  ResourceUri.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+
+/// The da_* signing parameters of a Bambuser resourceUri.
+struct ResourceUri {
+    let string: String
+    let signatureMethod: String?
+    let timestamp: TimeInterval?
+    /// Lifetime in seconds from timestamp; 0 means the signature does not expire.
+    let ttl: TimeInterval
+
+    init?(_ string: String) {
+        guard let components = URLComponents(string: string) else {
+            return nil
+        }
+        var query = [String: String]()
+        for item in components.queryItems ?? [] {
+            query[item.name] = item.value
+        }
+        self.string = string
+        signatureMethod = query["da_signature_method"]
+        timestamp = query["da_timestamp"].flatMap { TimeInterval($0) }
+        ttl = query["da_ttl"].flatMap { TimeInterval($0) } ?? 0
+    }
+
+    var expiresAt: Date? {
+        guard let timestamp = timestamp, ttl > 0 else {
+            return nil
+        }
+        return Date(timeIntervalSince1970: timestamp + ttl)
+    }
+
+    func isExpired(at date: Date = Date()) -> Bool {
+        guard let expiresAt = expiresAt else {
+            return false
+        }
+        return date >= expiresAt
+    }
+}
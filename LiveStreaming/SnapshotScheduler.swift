@@ -0,0 +1,81 @@
+//
+//  SnapshotScheduler.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import UIKit
+import BambuserBroadcaster
+
+/// Requests snapshots from BambuserView, either once or as a burst of N per second,
+/// with at most one request outstanding so calls never pile up on the capture side.
+/// The library has already cropped the image to the broadcast aspect; it is only
+/// scaled down here, on a background queue.
+class SnapshotScheduler: NSObject {
+    /// A request older than this is considered lost and no longer blocks new ones.
+    static let timeout: TimeInterval = 2
+
+    /// Delivers the thumbnail and, when it answers a pending request, how long the
+    /// snapshot took.
+    var onSnapshot: ((UIImage, TimeInterval?) -> Void)?
+
+    /// Longest side of delivered images, in pixels.
+    var maxThumbnailDimension: CGFloat = 320
+
+    private weak var bambuserView: BambuserView?
+    private let queue = DispatchQueue(label: "SnapshotScheduler", qos: .utility)
+    private var timer: Timer?
+    private var requestedAt: Date?
+
+    init(bambuserView: BambuserView) {
+        self.bambuserView = bambuserView
+        super.init()
+    }
+
+    deinit {
+        timer?.invalidate()
+    }
+
+    @objc func takeSnapshot() {
+        if let requestedAt = requestedAt, Date().timeIntervalSince(requestedAt) < SnapshotScheduler.timeout {
+            return
+        }
+        requestedAt = Date()
+        bambuserView?.takeSnapshot()
+    }
+
+    func startBurst(perSecond rate: Double) {
+        stopBurst()
+        timer = Timer.scheduledTimer(withTimeInterval: 1 / rate, repeats: true) { [weak self] _ in
+            self?.takeSnapshot()
+        }
+    }
+
+    func stopBurst() {
+        timer?.invalidate()
+        timer = nil
+    }
+
+    func snapshotTaken(_ image: UIImage) {
+        let latency = requestedAt.map { Date().timeIntervalSince($0) }
+        requestedAt = nil
+        let maxDimension = maxThumbnailDimension
+        queue.async { [weak self] in
+            let thumbnail = SnapshotScheduler.thumbnail(of: image, maxDimension: maxDimension)
+            DispatchQueue.main.async {
+                self?.onSnapshot?(thumbnail, latency)
+            }
+        }
+    }
+
+    private static func thumbnail(of image: UIImage, maxDimension: CGFloat) -> UIImage {
+        let scale = min(maxDimension / max(image.size.width, image.size.height), 1)
+        let size = CGSize(width: (image.size.width * scale).rounded(), height: (image.size.height * scale).rounded())
+        let format = UIGraphicsImageRendererFormat.default()
+        format.scale = 1
+        return UIGraphicsImageRenderer(size: size, format: format).image { _ in
+            image.draw(in: CGRect(origin: CGPoint.zero, size: size))
+        }
+    }
+}
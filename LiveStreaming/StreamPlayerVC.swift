@@ -10,29 +10,41 @@ import BambuserPlayer
 import AVFAudio
 
 class ViewController: UIViewController, BambuserPlayerDelegate {
+    static let resourceUri = "https://cdn.bambuser.net/broadcasts/ec968ec1-2fd9-f8f3-4f0a-d8e19dccd739?da_signature_method=HMAC-SHA256&da_id=432cebc3-4fde-5cbb-e82f-88b013140ebe&da_timestamp=1456740399&da_static=1&da_ttl=0&da_signature=8e0f9b98397c53e58f9d06d362e1de3cb6b69494e5d0e441307dfc9f854a2479"
     var bambuserPlayer: BambuserPlayer
     var playButton: UIButton
     var pauseButton: UIButton
     var rewindButton: UIButton
+    var statusLabel: UILabel
+    var latencyEstimator: LatencyEstimator
+    let latencyPolicy = LatencyModePolicy()
+    var playRequestedAt: Date?
+    var loadStarted = false
 
     required init?(coder aDecoder: NSCoder) {
         bambuserPlayer = BambuserPlayer()
         playButton = UIButton(type: UIButton.ButtonType.system)
         pauseButton = UIButton(type: UIButton.ButtonType.system)
         rewindButton = UIButton(type: UIButton.ButtonType.system)
+        statusLabel = UILabel()
+        latencyEstimator = LatencyEstimator(player: bambuserPlayer)
         super.init(coder: aDecoder)
+        latencyEstimator.onEstimate = { measurement in
+            NSLog("End-to-end latency %.2f s (+/- %.2f s)", measurement.latency, measurement.uncertainty)
+        }
+    }
+
+    deinit {
+        // The player goes away with this screen without reporting Stopped, so record the session here.
+        latencyPolicy.ended()
+        latencyEstimator.stop()
     }
 
     override func viewDidLoad() {
         super.viewDidLoad()
-        do {
-            try AVAudioSession.sharedInstance().setCategory(.playback)
-            try    AVAudioSession.sharedInstance().setActive(true)
-        } catch {}
-
         bambuserPlayer.delegate = self
         bambuserPlayer.applicationId = "GFZalqkR5iyZcIgaolQmA"
-        bambuserPlayer.playVideo("https://cdn.bambuser.net/broadcasts/ec968ec1-2fd9-f8f3-4f0a-d8e19dccd739?da_signature_method=HMAC-SHA256&da_id=432cebc3-4fde-5cbb-e82f-88b013140ebe&da_timestamp=1456740399&da_static=1&da_ttl=0&da_signature=8e0f9b98397c53e58f9d06d362e1de3cb6b69494e5d0e441307dfc9f854a2479")
+        bambuserPlayer.latencyMode = latencyPolicy.recommendedMode()
         self.view.addSubview(bambuserPlayer)
         playButton.setTitle("Play", for: UIControl.State.normal)
         playButton.addTarget(bambuserPlayer, action: #selector(BambuserPlayer.playVideo as (BambuserPlayer) -> () -> Void), for: UIControl.Event.touchUpInside)
@@ -43,6 +55,41 @@ class ViewController: UIViewController, BambuserPlayerDelegate {
         rewindButton.setTitle("Rewind", for: UIControl.State.normal)
         rewindButton.addTarget(self, action: #selector(ViewController.rewind), for: UIControl.Event.touchUpInside)
         self.view.addSubview(rewindButton)
+        statusLabel.textColor = UIColor.white
+        statusLabel.isHidden = true
+        self.view.addSubview(statusLabel)
+    }
+
+    override func viewWillAppear(_ animated: Bool) {
+        super.viewWillAppear(animated)
+        // Load only once the screen is about to show, so a controller that is
+        // created but not presented does not start audio off-screen.
+        if !loadStarted {
+            loadStarted = true
+            load()
+        }
+    }
+
+    func load() {
+        if let uri = ResourceUri(ViewController.resourceUri), uri.isExpired() {
+            NSLog("Signature expired for %@", uri.string)
+            showError("This broadcast link has expired")
+            return
+        }
+        do {
+            try AVAudioSession.sharedInstance().setCategory(.playback)
+            try    AVAudioSession.sharedInstance().setActive(true)
+        } catch {}
+        playRequestedAt = Date()
+        bambuserPlayer.playVideo(ViewController.resourceUri)
+    }
+
+    func showError(_ message: String) {
+        statusLabel.text = message
+        statusLabel.isHidden = false
+        playButton.isEnabled = false
+        pauseButton.isEnabled = false
+        rewindButton.isEnabled = false
     }
 
     @objc func rewind() {
@@ -55,6 +102,7 @@ class ViewController: UIViewController, BambuserPlayerDelegate {
         playButton.frame = CGRect(x: 20, y: 20 + statusBarOffset, width: 100, height: 40)
         pauseButton.frame = CGRect(x: 20, y: 80 + statusBarOffset, width: 100, height: 40)
         rewindButton.frame = CGRect(x: 20, y: 140 + statusBarOffset, width: 100, height: 40)
+        statusLabel.frame = CGRect(x: 20, y: 200 + statusBarOffset, width: self.view.bounds.size.width - 40, height: 40)
     }
 
     func playbackStatusChanged(_ status: BambuserPlayerState) {
@@ -62,20 +110,38 @@ class ViewController: UIViewController, BambuserPlayerDelegate {
         case kBambuserPlayerStatePlaying:
             playButton.isEnabled = false
             pauseButton.isEnabled = true
+            if bambuserPlayer.live {
+                latencyEstimator.start()
+            }
+            latencyPolicy.playing(live: bambuserPlayer.live)
+            if let playRequestedAt = playRequestedAt {
+                NSLog("Time to first frame %.2f s", Date().timeIntervalSince(playRequestedAt))
+            }
+            playRequestedAt = nil
             break
 
         case kBambuserPlayerStatePaused:
             playButton.isEnabled = true
             pauseButton.isEnabled = false
+            latencyPolicy.paused()
+            break
+
+        case kBambuserPlayerStateBuffering:
+            latencyPolicy.buffering()
             break
 
         case kBambuserPlayerStateStopped:
             playButton.isEnabled = true
             pauseButton.isEnabled = false
+            latencyEstimator.stop()
+            latencyPolicy.ended()
             break
 
         case kBambuserPlayerStateError:
             NSLog("Failed to load video for %@", bambuserPlayer.resourceUri);
+            showError("Failed to load video")
+            latencyEstimator.stop()
+            latencyPolicy.ended()
             break
 
         default:
@@ -11,6 +11,24 @@ class StreamingVC: UIViewController, BambuserViewDelegate {
     
     var bambuserView: BambuserView
     var broadcastButton: UIButton
+    let qualityController = BroadcastQualityController()
+    var uplinkMonitor: UplinkMonitor
+    var audioLevelMeter: AudioLevelMeter
+    var levelView: UIProgressView
+    var snapshotScheduler: SnapshotScheduler
+    var snapshotButton: UIButton
+    var thumbnailView: UIImageView
+    var recordSwitch: UISwitch
+    var chatFeed: ChatFeed
+    let eventBus = BroadcastEventBus()
+    let timings = BroadcastTimings()
+    var broadcastRequestedAt: Date?
+    var currentViewers = 0
+    var totalViewers = 0
+    var disconnectedAt: Date?
+    var recordLocally = false
+    /// Thumbnails taken per second while broadcasting.
+    static let thumbnailRate = 0.2
     
     required init?(coder aDecoder: NSCoder) {
         if #available(iOS 14.5, *) {
@@ -20,20 +38,77 @@ class StreamingVC: UIViewController, BambuserViewDelegate {
         }
         bambuserView = BambuserView(preparePreset: kSessionPresetAuto)
         broadcastButton = UIButton(type: UIButton.ButtonType.system)
+        uplinkMonitor = UplinkMonitor(bambuserView: bambuserView)
+        audioLevelMeter = AudioLevelMeter(bambuserView: bambuserView)
+        levelView = UIProgressView(progressViewStyle: UIProgressView.Style.bar)
+        snapshotScheduler = SnapshotScheduler(bambuserView: bambuserView)
+        snapshotButton = UIButton(type: UIButton.ButtonType.system)
+        thumbnailView = UIImageView()
+        recordSwitch = UISwitch()
+        chatFeed = ChatFeed(bambuserView: bambuserView)
         super.init(coder: aDecoder)
         bambuserView.delegate = self
         bambuserView.applicationId = "GFZalqkR5iyZcIgaolQmA"
+        qualityController.onDecision = { [weak self] decision in
+            NSLog("Quality step: %ld max dimension, %.0f fps (health %.0f)", decision.maxBroadcastDimension, decision.framerate, decision.smoothedHealth)
+            self?.bambuserView.setFramerate(decision.framerate, minFramerate: BroadcastQualityController.minFramerate)
+        }
+        uplinkMonitor.onUpdate = { [weak self] speed, shouldBroadcast in
+            NSLog("Uplink %.0f bytes/s, recommended: %d", speed, shouldBroadcast ? 1 : 0)
+            self?.qualityController.uplinkMeasured(bytesPerSecond: speed)
+        }
+        audioLevelMeter.onLevels = { [weak self] levels in
+            self?.levelView.progress = AudioLevelMeter.normalized(levels.average)
+        }
+        snapshotScheduler.onSnapshot = { [weak self] image, latency in
+            if let latency = latency {
+                self?.timings.record(.snapshot, latency)
+            }
+            self?.thumbnailView.image = image
+        }
+        eventBus.onBatch = { [weak self] batch in
+            self?.handle(batch)
+        }
     }
     
+    deinit {
+        // The display link retains the feed until it is invalidated.
+        chatFeed.stop()
+    }
+
     override func viewDidLoad() {
         super.viewDidLoad()
         bambuserView.orientation = UIApplication.shared.statusBarOrientation
+        // Capture range only; the streamed framerate may still drop below minFramerate.
+        bambuserView.setFramerate(qualityController.framerate, minFramerate: BroadcastQualityController.minFramerate)
         self.view.addSubview(bambuserView.view)
         bambuserView.startCapture()
+        uplinkMonitor.start()
 
         broadcastButton.addTarget(self, action: #selector(StreamingVC.broadcast), for: UIControl.Event.touchUpInside)
         broadcastButton.setTitle("Broadcast", for: UIControl.State.normal)
         self.view.addSubview(broadcastButton)
+        self.view.addSubview(levelView)
+        snapshotButton.addTarget(snapshotScheduler, action: #selector(SnapshotScheduler.takeSnapshot), for: UIControl.Event.touchUpInside)
+        snapshotButton.setTitle("Snapshot", for: UIControl.State.normal)
+        self.view.addSubview(snapshotButton)
+        thumbnailView.contentMode = UIView.ContentMode.scaleAspectFit
+        self.view.addSubview(thumbnailView)
+        recordSwitch.addTarget(self, action: #selector(StreamingVC.recordToggled), for: UIControl.Event.valueChanged)
+        self.view.addSubview(recordSwitch)
+        if let chatView = bambuserView.chatView {
+            self.view.addSubview(chatView)
+        }
+    }
+
+    override func viewWillAppear(_ animated: Bool) {
+        super.viewWillAppear(animated)
+        audioLevelMeter.start()
+    }
+
+    override func viewDidDisappear(_ animated: Bool) {
+        super.viewDidDisappear(animated)
+        audioLevelMeter.stop()
     }
 
     override func viewWillLayoutSubviews() {
@@ -41,6 +116,15 @@ class StreamingVC: UIViewController, BambuserViewDelegate {
         statusBarOffset = CGFloat(self.topLayoutGuide.length)
         bambuserView.previewFrame = CGRect(x: 0.0, y: 0.0 + statusBarOffset, width: self.view.bounds.size.width, height: self.view.bounds.size.height - statusBarOffset)
         broadcastButton.frame = CGRect(x: 0.0, y: 0.0 + statusBarOffset, width: 100.0, height: 50.0);
+        levelView.frame = CGRect(x: 0.0, y: 50.0 + statusBarOffset, width: 100.0, height: 4.0);
+        snapshotButton.frame = CGRect(x: 0.0, y: 60.0 + statusBarOffset, width: 100.0, height: 50.0);
+        recordSwitch.frame = CGRect(x: 0.0, y: 115.0 + statusBarOffset, width: 51.0, height: 31.0);
+        thumbnailView.frame = CGRect(x: self.view.bounds.size.width - 160.0, y: 0.0 + statusBarOffset, width: 160.0, height: 90.0);
+        bambuserView.chatView?.frame = CGRect(x: 0.0, y: self.view.bounds.size.height * 2.0 / 3.0, width: self.view.bounds.size.width, height: self.view.bounds.size.height / 3.0);
+    }
+
+    @objc func recordToggled() {
+        recordLocally = recordSwitch.isOn
     }
 
     @objc func broadcast() {
@@ -48,20 +132,161 @@ class StreamingVC: UIViewController, BambuserViewDelegate {
         broadcastButton.setTitle("Connecting", for: UIControl.State.normal)
         broadcastButton.removeTarget(nil, action: nil, for: UIControl.Event.touchUpInside)
         broadcastButton.addTarget(bambuserView, action: #selector(bambuserView.stopBroadcasting), for: UIControl.Event.touchUpInside)
+        uplinkMonitor.stop()
+        // saveLocally can not change during a broadcast.
+        recordSwitch.isEnabled = false
+        bambuserView.saveLocally = recordLocally && LocalRecording.hasRoom()
+        if recordLocally && !bambuserView.saveLocally {
+            NSLog("Not enough free space, broadcasting without a local copy")
+        }
+        bambuserView.maxBroadcastDimension = Int32(qualityController.maxBroadcastDimension)
+        broadcastRequestedAt = Date()
         bambuserView.startBroadcasting()
     }
 
-    func broadcastStarted() {
+    func handle(_ batch: BroadcastEventBus.Batch) {
+        for state in batch.states {
+            switch state {
+            case .started:
+                handleBroadcastStarted()
+            case .stopped:
+                handleBroadcastStopped()
+            case .disconnected:
+                handleBroadcastDisconnected()
+            case .resumed:
+                handleBroadcastResumed()
+            }
+        }
+        if let health = batch.health {
+            qualityController.healthUpdated(health)
+        }
+        if let viewers = batch.currentViewers {
+            currentViewers = viewers
+        }
+        if let viewers = batch.totalViewers {
+            totalViewers = viewers
+        }
+    }
+
+    func handleBroadcastStarted() {
         NSLog("Received broadcastStarted signal")
+        if let broadcastRequestedAt = broadcastRequestedAt {
+            timings.record(.connect, Date().timeIntervalSince(broadcastRequestedAt))
+        }
+        broadcastRequestedAt = nil
+        currentViewers = 0
+        totalViewers = 0
+        qualityController.broadcastStarted()
+        snapshotScheduler.startBurst(perSecond: StreamingVC.thumbnailRate)
         broadcastButton.setTitle("Stop", for: UIControl.State.normal)
         broadcastButton.removeTarget(nil, action: nil, for: UIControl.Event.touchUpInside)
         broadcastButton.addTarget(bambuserView, action: #selector(bambuserView.stopBroadcasting), for: UIControl.Event.touchUpInside)
     }
 
-    func broadcastStopped() {
+    func handleBroadcastStopped() {
         NSLog("Received broadcastStopped signal")
+        broadcastRequestedAt = nil
+        disconnectedAt = nil
+        chatFeed.stop()
+        snapshotScheduler.stopBurst()
+        qualityController.broadcastStopped()
+        NSLog("Stalls: %ld, average recovery %.2f s", qualityController.stallCount, qualityController.averageRecoveryTime ?? 0)
+        timings.log()
+        NSLog("Viewers: %ld total, %ld at end; %ld callbacks in %ld batches", totalViewers, currentViewers, eventBus.postedCount, eventBus.deliveredCount)
+        uplinkMonitor.start()
+        recordSwitch.isEnabled = true
         broadcastButton.setTitle("Broadcast", for: UIControl.State.normal)
         broadcastButton.removeTarget(nil, action: nil, for: UIControl.Event.touchUpInside)
         broadcastButton.addTarget(self, action: #selector(StreamingVC.broadcast), for: UIControl.Event.touchUpInside)
     }
+
+    func handleBroadcastDisconnected() {
+        NSLog("Received broadcastDisconnected signal")
+        disconnectedAt = Date()
+        broadcastButton.setTitle("Reconnecting", for: UIControl.State.normal)
+    }
+
+    func handleBroadcastResumed() {
+        if let disconnectedAt = disconnectedAt {
+            let interval = Date().timeIntervalSince(disconnectedAt)
+            timings.record(.reconnect, interval)
+            NSLog("Received broadcastResumed signal after %.2f s", interval)
+        }
+        disconnectedAt = nil
+        broadcastButton.setTitle("Stop", for: UIControl.State.normal)
+    }
+
+    // BambuserViewDelegate callbacks may arrive on any thread. State, health and
+    // viewer counts go through the event bus, which delivers on the main queue;
+    // the remaining callbacks hop to main themselves.
+    func broadcastStarted() {
+        eventBus.post(.started)
+    }
+
+    func broadcastStopped() {
+        eventBus.post(.stopped)
+    }
+
+    func broadcastDisconnected() {
+        eventBus.post(.disconnected)
+    }
+
+    func broadcastResumed() {
+        eventBus.post(.resumed)
+    }
+
+    func recordingComplete(_ filename: String!) {
+        guard let filename = filename else {
+            return
+        }
+        LocalRecording.archive(filename) { url in
+            NSLog("Recording saved to %@", url?.path ?? filename)
+        }
+    }
+
+    func bambuserError(_ errorCode: BambuserError, message errorMessage: String!) {
+        NSLog("Received bambuserError %d: %@", errorCode.rawValue, errorMessage ?? "")
+        DispatchQueue.main.async {
+            if errorCode == kBambuserErrorNoFreeSpace {
+                self.recordLocally = false
+                self.recordSwitch.setOn(false, animated: true)
+            }
+        }
+    }
+
+    func chatMessageReceived(_ message: String!) {
+        guard let message = message else {
+            return
+        }
+        DispatchQueue.main.async {
+            self.chatFeed.receive(message)
+        }
+    }
+
+    func snapshotTaken(_ image: UIImage!) {
+        guard let image = image else {
+            return
+        }
+        DispatchQueue.main.async {
+            self.snapshotScheduler.snapshotTaken(image)
+        }
+    }
+
+    func uplinkTestComplete(_ speed: Float, recommendation shouldBroadcast: Bool) {
+        DispatchQueue.main.async {
+            self.uplinkMonitor.testCompleted(speed: speed, recommendation: shouldBroadcast)
+        }
+    }
+
+    func healthUpdated(_ health: Int32) {
+        eventBus.postHealth(Int(health))
+    }
+
+    func currentViewerCountUpdated(_ viewers: Int32) {
+        eventBus.postCurrentViewers(Int(viewers))
+    }
+
+    func totalViewerCountUpdated(_ viewers: Int32) {
+        eventBus.postTotalViewers(Int(viewers))
+    }
 }
@@ -0,0 +1,87 @@
+//
+//  UplinkMonitor.swift
+//  LiveStreaming
+//
+//  Created by Anil Choudhary on 18/10/26.
+//
+
+import Foundation
+import BambuserBroadcaster
+
+/// Repeats the BambuserView linktest while the camera is previewing, so the
+/// uplink speed and recommendation stay current until the broadcast starts
+/// instead of being measured once. The interval doubles after every good
+/// result, so a long preview costs only a handful of tests.
+class UplinkMonitor {
+    static let initialInterval: TimeInterval = 30
+    static let maxInterval: TimeInterval = 600
+
+    var onUpdate: ((Float, Bool) -> Void)?
+
+    private(set) var speed: Float = 0
+    private(set) var shouldBroadcast = false
+
+    private weak var bambuserView: BambuserView?
+    private var timer: Timer?
+    private var active = false
+    private var testRunning = false
+    private var interval = UplinkMonitor.initialInterval
+    private var lastResultAt: Date?
+
+    init(bambuserView: BambuserView) {
+        self.bambuserView = bambuserView
+    }
+
+    deinit {
+        timer?.invalidate()
+    }
+
+    func start() {
+        if active {
+            return
+        }
+        active = true
+        let elapsed = lastResultAt.map { Date().timeIntervalSince($0) } ?? interval
+        schedule(after: max(interval - elapsed, 0))
+    }
+
+    func stop() {
+        active = false
+        timer?.invalidate()
+        timer = nil
+        testRunning = false
+    }
+
+    func testCompleted(speed measured: Float, recommendation: Bool) {
+        testRunning = false
+        // A failed linktest reports -1; retry at the initial interval.
+        if measured < 0 {
+            interval = UplinkMonitor.initialInterval
+        } else {
+            speed = speed == 0 ? measured : speed * 0.5 + measured * 0.5
+            shouldBroadcast = recommendation
+            lastResultAt = Date()
+            interval = min(interval * 2, UplinkMonitor.maxInterval)
+            onUpdate?(speed, shouldBroadcast)
+        }
+        if active {
+            schedule(after: interval)
+        }
+    }
+
+    private func schedule(after delay: TimeInterval) {
+        timer?.invalidate()
+        timer = Timer.scheduledTimer(withTimeInterval: delay, repeats: false) { [weak self] _ in
+            self?.timer = nil
+            self?.runTest()
+        }
+    }
+
+    private func runTest() {
+        if testRunning {
+            return
+        }
+        testRunning = true
+        bambuserView?.startLinktest()
+    }
+}